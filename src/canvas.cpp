@@ -0,0 +1,112 @@
+#include "canvas.h"
+#include <cstdlib>
+#include <cstring>
+
+// Default font height in pixels, DrawText never goes smaller than this
+const int defaultFontSize = 10;
+
+static inline Color* pixelAt(Image* canvas, int x, int y) {
+    return &((Color*)canvas->data)[y * canvas->width + x];
+}
+
+static inline void blend(Color* dst, Color src) {
+    int a = src.a;
+    dst->r = (src.r * a + dst->r * (255 - a)) / 255;
+    dst->g = (src.g * a + dst->g * (255 - a)) / 255;
+    dst->b = (src.b * a + dst->b * (255 - a)) / 255;
+}
+
+Image canvasCreate(int width, int height) {
+    return GenImageColor(width, height, (Color){0, 0, 0, 255});
+}
+
+void canvasClear(Image* canvas, Color color) {
+    color.a = 255;
+    Color* pixels = (Color*)canvas->data;
+    for (int i = 0; i < canvas->width * canvas->height; i++) {
+        pixels[i] = color;
+    }
+}
+
+void canvasDrawPixel(Image* canvas, int x, int y, Color color) {
+    if (x < 0 || y < 0 || x >= canvas->width || y >= canvas->height) {
+        return;
+    }
+    blend(pixelAt(canvas, x, y), color);
+}
+
+void canvasDrawLine(Image* canvas, int startX, int startY, int endX, int endY, Color color) {
+    // Bresenham, stopping one short of the end point
+    int dx = abs(endX - startX);
+    int dy = -abs(endY - startY);
+    int stepX = startX < endX ? 1 : -1;
+    int stepY = startY < endY ? 1 : -1;
+    int error = dx + dy;
+    int x = startX;
+    int y = startY;
+    while (x != endX || y != endY) {
+        canvasDrawPixel(canvas, x, y, color);
+        int error2 = 2 * error;
+        if (error2 >= dy) {
+            error += dy;
+            x += stepX;
+        }
+        if (error2 <= dx) {
+            error += dx;
+            y += stepY;
+        }
+    }
+}
+
+void canvasDrawRectangle(Image* canvas, int x, int y, int width, int height, Color color) {
+    for (int yy = y; yy < y + height; yy++) {
+        for (int xx = x; xx < x + width; xx++) {
+            canvasDrawPixel(canvas, xx, yy, color);
+        }
+    }
+}
+
+void canvasDrawImage(Image* canvas, const Image& image, int x, int y) {
+    Color* pixels = (Color*)image.data;
+    for (int yy = 0; yy < image.height; yy++) {
+        for (int xx = 0; xx < image.width; xx++) {
+            canvasDrawPixel(canvas, x + xx, y + yy, pixels[yy * image.width + xx]);
+        }
+    }
+}
+
+void canvasDrawText(Image* canvas, const char* text, int x, int y, int size, Color color) {
+    Image textImage = canvasTextImage(text, size, color);
+    canvasDrawImage(canvas, textImage, x, y);
+    UnloadImage(textImage);
+}
+
+void canvasMultiply(Image* canvas, Color color) {
+    Color* pixels = (Color*)canvas->data;
+    for (int i = 0; i < canvas->width * canvas->height; i++) {
+        pixels[i].r = pixels[i].r * color.r / 255;
+        pixels[i].g = pixels[i].g * color.g / 255;
+        pixels[i].b = pixels[i].b * color.b / 255;
+    }
+}
+
+void canvasCopy(Image* canvas, const Image& image, int x, int y) {
+    // Only used to place whole clocks on the panel chain, so rows are copied directly
+    if (x < 0 || y < 0 || x + image.width > canvas->width || y + image.height > canvas->height) {
+        return;
+    }
+    Color* pixels = (Color*)image.data;
+    for (int yy = 0; yy < image.height; yy++) {
+        memcpy(pixelAt(canvas, x, y + yy), &pixels[yy * image.width], image.width * sizeof(Color));
+    }
+}
+
+Image canvasTextImage(const char* text, int size, Color color) {
+    if (size < defaultFontSize) {
+        size = defaultFontSize;
+    }
+    // Reads the default font's glyph images only, no GL access
+    Image textImage = ImageTextEx(GetFontDefault(), text, (float)size, (float)(size / defaultFontSize), color);
+    ImageFormat(&textImage, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    return textImage;
+}
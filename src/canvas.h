@@ -0,0 +1,27 @@
+#pragma once
+
+#include "raylib.h"
+
+// CPU-side equivalents of the raylib Draw* calls used by the clock face.
+// They only touch the pixels of the given R8G8B8A8 image and never call into
+// GL, so separate images can be drawn from separate threads at the same time.
+// Colors are alpha blended like BLEND_ALPHA, canvases stay fully opaque.
+
+Image canvasCreate(int width, int height);
+void canvasClear(Image* canvas, Color color);
+
+void canvasDrawPixel(Image* canvas, int x, int y, Color color);
+// Like DrawLine, the end point is not drawn
+void canvasDrawLine(Image* canvas, int startX, int startY, int endX, int endY, Color color);
+void canvasDrawRectangle(Image* canvas, int x, int y, int width, int height, Color color);
+void canvasDrawImage(Image* canvas, const Image& image, int x, int y);
+void canvasDrawText(Image* canvas, const char* text, int x, int y, int size, Color color);
+
+// Like BLEND_MULTIPLIED with an opaque color
+void canvasMultiply(Image* canvas, Color color);
+
+// Plain copy of every pixel of image into canvas, no blending
+void canvasCopy(Image* canvas, const Image& image, int x, int y);
+
+// Text rendered with the default font, sized the same way DrawText sizes it
+Image canvasTextImage(const char* text, int size, Color color);
@@ -0,0 +1,388 @@
+#include "clock_instance.h"
+#include "canvas.h"
+#include <iostream>
+#include <chrono>
+#include <ctime>
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// Minimum time between weather queries for one clock
+const uint64_t weatherQueryIntervalMillis = 60000;
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+void drawOutlinedText(Image* canvas, const char* text, int x, int y, int size, Color bg, Color fg) {
+    // Rasterize the outline once and stamp it around the text
+    Image outline = canvasTextImage(text, size, bg);
+    canvasDrawImage(canvas, outline, x-1, y-1);
+    canvasDrawImage(canvas, outline, x-0, y-1);
+    canvasDrawImage(canvas, outline, x+1, y-1);
+    canvasDrawImage(canvas, outline, x-1, y-0);
+    canvasDrawImage(canvas, outline, x-0, y-0);
+    canvasDrawImage(canvas, outline, x+1, y-0);
+    canvasDrawImage(canvas, outline, x-1, y+1);
+    canvasDrawImage(canvas, outline, x-0, y+1);
+    canvasDrawImage(canvas, outline, x+1, y+1);
+    UnloadImage(outline);
+
+    canvasDrawText(canvas, text, x, y, size, fg);
+}
+
+// Swap sun icons for moon icons at night
+WeatherType weatherTypeForTimeOfDay(WeatherType weatherType, bool isDaytime) {
+    if (isDaytime) {
+        return weatherType;
+    }
+    if (weatherType == WeatherType::full_sun) {
+        return WeatherType::full_moon;
+    }
+    if (weatherType == WeatherType::partial_sun) {
+        return WeatherType::partial_moon;
+    }
+    return weatherType;
+}
+
+ClockInstance::ClockInstance(const ClockConfig& config, int _width, int _height)
+    : daylight(config.latitude, config.longitude) {
+    std::cout << "Initializing clock " << config.name << std::endl;
+
+    this->clockConfig = config;
+    this->width = _width;
+    this->height = _height;
+    this->canvas = canvasCreate(_width, _height);
+
+    // Zone data is loaded once up front, conversions after this never touch the filesystem
+    if (!timeZone.load(config.timezone)) {
+        std::cout << "Falling back to UTC for " << config.name << std::endl;
+    }
+
+    this->lastWeatherQuery = 0;
+    for (int i = 0; i < 24; i++) {
+        temperatures[i] = 60;
+    }
+    this->weatherEnum = WeatherType::full_sun;
+    this->weatherIcon = WeatherType::full_sun;
+    this->secondInDay = 0;
+
+    time_t now = time(nullptr);
+    daylight.update(timeZone.localMidnight(now));
+    std::cout << "Sunrise today in " << config.name << ": " << daylight.sunriseSecondsTime() << "s" << std::endl;
+    std::cout << "Sunset today in " << config.name << ": " << daylight.sunsetSecondsTime() << "s" << std::endl;
+}
+
+ClockInstance::~ClockInstance() {
+    UnloadImage(canvas);
+}
+
+const Image& ClockInstance::image() const {
+    return canvas;
+}
+
+const ClockConfig& ClockInstance::config() const {
+    return clockConfig;
+}
+
+void ClockInstance::queryWeather() {
+    std::cout << "Querying weather API for " << clockConfig.name << "..." << std::endl;
+
+    // Runs in the background, picked up by a later update()
+    pendingWeatherQuery = cpr::GetAsync(
+        cpr::Url{fmt::format("https://api.open-meteo.com/v1/forecast?latitude={:.2f}&longitude={:.2f}&hourly=temperature_2m,weathercode&current_weather=true&temperature_unit=fahrenheit&timeformat=unixtime", clockConfig.latitude, clockConfig.longitude)});
+}
+
+void ClockInstance::parseWeather(const cpr::Response& r) {
+    if (r.status_code == 200) {
+        try {
+            json rawPayload = json::parse(r.text);
+            //std::cout << rawPayload.dump(4) << std::endl;
+
+            auto& currentWeather = rawPayload["current_weather"];
+
+            std::vector<double> temperatureData = rawPayload["hourly"]["temperature_2m"];
+            std::vector<uint64_t> timestamps = rawPayload["hourly"]["time"];
+
+            // Find the next 24 temperature and forecast values
+            int i = 0;
+            for (auto& ts: timestamps) {
+                if (ts >= (lastWeatherQuery / 1000)) {
+                    int hourRelative = (int)((ts - (lastWeatherQuery / 1000)) / 3600.0);
+                    double temperature = temperatureData[i];
+                    if (hourRelative < 24) {
+                        std::cout << "Hour: " << hourRelative << "Temp: " << temperature << std::endl;
+                        temperatures[hourRelative] = temperature;
+                    }
+                }
+                i += 1;
+            }
+
+            temperatures[0] = currentWeather["temperature"];
+            int currentWeatherCode = currentWeather["weathercode"];
+
+            std::cout << "Current time: " << lastWeatherQuery << std::endl;
+            std::cout << "Current weather code: " << currentWeatherCode << std::endl;
+            std::cout << "Current temperature: " << temperatures[0] << std::endl;
+
+            // Weather codes at bottom of https://open-meteo.com/en/docs
+            // Day/night variants are chosen per frame from the daylight timeline
+            /*
+            typedef enum WeatherType
+            {
+                full_sun = 1,
+                full_moon = 8,
+                partial_sun = 2,
+                partial_moon = 7,
+                cloudy = 3,
+                cloudy_rain = 4,
+                cloudy_snow = 5,
+                cloudy_thunder = 6
+            } WeatherType;
+            */
+            if (currentWeatherCode == 0 || currentWeatherCode == 1) {
+                // Clear sky, mainly clear
+                weatherEnum = WeatherType::full_sun;
+            } else if (currentWeatherCode == 2) {
+                // Partly cloudy
+                weatherEnum = WeatherType::partial_sun;
+            } else if (
+                currentWeatherCode == 3 || 
+                currentWeatherCode == 45 || 
+                currentWeatherCode == 48) {
+                // Overcast, fog
+                weatherEnum = WeatherType::cloudy;
+            } else if (
+                currentWeatherCode == 51 || 
+                currentWeatherCode == 53 || 
+                currentWeatherCode == 55 || 
+                currentWeatherCode == 56 ||
+                currentWeatherCode == 57 ||
+                currentWeatherCode == 61 || 
+                currentWeatherCode == 63 ||
+                currentWeatherCode == 65 ||
+                currentWeatherCode == 66 ||
+                currentWeatherCode == 67 || 
+                currentWeatherCode == 80 ||
+                currentWeatherCode == 81 ||
+                currentWeatherCode == 82) {
+                // raining
+                weatherEnum = WeatherType::cloudy_rain;
+            } else if (
+                currentWeatherCode == 71 ||
+                currentWeatherCode == 73 ||
+                currentWeatherCode == 75 ||
+                currentWeatherCode == 77 ||
+                currentWeatherCode == 85 ||
+                currentWeatherCode == 86) {
+                // snowing
+                weatherEnum = WeatherType::cloudy_snow;
+            } else if (
+                currentWeatherCode == 95 ||
+                currentWeatherCode == 96 ||
+                currentWeatherCode == 99) {
+                // thundering
+                weatherEnum = WeatherType::cloudy_thunder;
+            } else {
+                // Default: partial sun or moon
+                weatherEnum = WeatherType::partial_sun;
+            }
+        } catch (std::exception &e) {
+            std::cout << "Failed to parse weather API!" << e.what() << std::endl;
+        }
+    } else {
+        std::cout << "Failed to query weather API! Status code: " << r.status_code << "msg: " << r.text << std::endl;
+    }
+}
+
+void ClockInstance::update(uint64_t nowMillis) {
+    // Query weather data if it is expired
+    if (pendingWeatherQuery.valid()) {
+        if (pendingWeatherQuery.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            parseWeather(pendingWeatherQuery.get());
+        }
+    } else if (nowMillis - lastWeatherQuery > weatherQueryIntervalMillis) {
+        lastWeatherQuery = nowMillis;
+        queryWeather();
+    }
+
+    time_t now = nowMillis / 1000;
+    struct tm time = timeZone.toLocal(now);
+    std::strftime(timeBuffer, 256, "%I:%M%p", &time);
+    std::strftime(timeBuffer2, 256, "%I:%M", &time);
+    std::strftime(timeBuffer3, 256, "%M%p", &time);
+    std::strftime(dateBuffer, 256, "%b %e", &time);
+
+    time_t midnight = timeZone.localMidnight(now);
+    secondInDay = now - midnight;
+    daylight.update(midnight);
+    daylightSample = daylight.at(secondInDay);
+    weatherIcon = weatherTypeForTimeOfDay(weatherEnum, daylight.isDaytime(secondInDay));
+}
+
+void ClockInstance::render(const ClockAssets& assets) {
+    // Render to internal buffer of same resolution as physical screen
+
+    // DrawTexture(dayBg, 0, 0, (Color){255,255,255,255});
+    canvasClear(&canvas, (Color){daylightSample.tintR, daylightSample.tintG, daylightSample.tintB, 255});
+
+    // dither
+
+    Color currentTempColor = (Color){255,255,255,255};
+    if (temperatures[0] < 0) {
+        currentTempColor = (Color){255,255,255,255};
+    } else if (temperatures[0] >= 128) {
+        currentTempColor = (Color){255,50,50,255};
+    } else {
+        // Valid lookup
+        currentTempColor = assets.lookupColors[temperatures[0]];
+    }
+
+    for (int x = -1; x < 19; x++) {
+        for (int y = -1; y < 32; y++) {
+            if ((x+y) % 2) {
+                canvasDrawPixel(&canvas, x, y, Fade(currentTempColor, 0.3f));
+            }
+        }
+    }
+
+    // Draw background parallax tex
+    // DrawTexturePro(parallaxBgImg, (Rectangle){ 0, 0, 192,192 }, (Rectangle){32, 90, 192, 192}, (Vector2){96,96}, timeOfDayPercent * 360, WHITE); 
+
+    // Draw time and date
+    drawOutlinedText(&canvas, timeBuffer, 64 - MeasureText(timeBuffer, 5) - 2, 1, 5, (Color){0,0,0,255}, (Color){255,255,255,255});
+    drawOutlinedText(&canvas, dateBuffer, 64 - MeasureText(dateBuffer, 5) - 2, 11, 2, (Color){0,0,0,255}, (Color){255,255,255,255});
+
+    // make everything rendered before this half as bright
+    canvasDrawRectangle(&canvas, 0, 0, 64, 32, (Color){0,0,0,128});
+
+    // Draw weather icon
+    if (weatherIcon == WeatherType::full_sun) {
+        canvasDrawImage(&canvas, assets.weatherIconSun, 1, 11);
+    } else if (weatherIcon == WeatherType::partial_sun) {
+        canvasDrawImage(&canvas, assets.weatherIconCloud1, 1, 11);
+    } else if (weatherIcon == WeatherType::cloudy) {
+        canvasDrawImage(&canvas, assets.weatherIconCloud2, 1, 11);
+    } else if (weatherIcon == WeatherType::cloudy_rain) {
+        canvasDrawImage(&canvas, assets.weatherIconCloud3, 1, 11);
+    } else if (weatherIcon == WeatherType::cloudy_snow) {
+        canvasDrawImage(&canvas, assets.weatherIconSnow, 1, 11);
+    } else if (weatherIcon == WeatherType::cloudy_thunder) {
+        canvasDrawImage(&canvas, assets.weatherIconCloud4, 1, 11);
+    } else if (weatherIcon == WeatherType::partial_moon) {
+        canvasDrawImage(&canvas, assets.weatherIconMoonCloud1, 1, 11);
+    } else if (weatherIcon == WeatherType::full_moon) {
+        canvasDrawImage(&canvas, assets.weatherIconMoon, 1, 11);
+    } else {
+        canvasDrawImage(&canvas, assets.weatherIconCloud2, 1, 11);
+    }
+
+    
+    drawOutlinedText(&canvas, timeBuffer2, 64 - MeasureText(timeBuffer, 5) - 2, 1, 5, (Color){0,0,0,255}, (Color){255,255,255,255});
+    
+    if (secondInDay % 2 == 0) {
+        canvasDrawRectangle(&canvas, 64 - MeasureText(timeBuffer3, 5) - 4, 0, 1, 12, (Color){0,0,0,255});
+    }
+
+    // find max and min temperatures
+    int tempDisplayHeight = 10;
+    int minTemperature = 999;
+    int maxTemperature = -999;
+    for (int i = 0; i < 24; i++) {
+        if (temperatures[i] < minTemperature) {
+            minTemperature = temperatures[i];
+        }
+        if (temperatures[i] > maxTemperature) {
+            maxTemperature = temperatures[i];
+        }
+    }
+    int tempRange = (maxTemperature - minTemperature);
+    if (tempRange < 10) {
+        int centerTemp = (maxTemperature + minTemperature) / 2;
+        minTemperature = centerTemp - 5;
+        maxTemperature = centerTemp + 5;
+    }
+
+    // canvasDrawRectangle(&canvas, 0, 0, 1, 1, (Color){0,0,255,255});
+
+    // Draw temperature line for the current day
+    for (int i = 0; i < 24; i++) {
+        int temp_xx = 19 + (i*2);
+        int temp = temperatures[i];
+        int temp_yy = 31 - (map(temp, minTemperature, maxTemperature, 1, tempDisplayHeight));
+
+        Color tempColor = (Color){255,255,255,255};
+        if (temp < 0) {
+            tempColor = (Color){255,255,255,255};
+        } else if (temp >= 128) {
+            tempColor = (Color){255,50,50,255};
+        } else {
+            // Valid lookup
+            tempColor = assets.lookupColors[temp];
+        }
+
+        float fadePrimaryAmount = 0.25f;
+        float fadeSecondaryAmount = 0.6f;
+
+        int secondTime = i * 60 * 60;
+        // if (!daylight.isDaytime(secondTime)) {
+        //     // Nighttime
+        //     fadePrimaryAmount = 0.1f;
+        //     fadeSecondaryAmount = 0.05f;
+        // }
+
+        canvasDrawLine(&canvas, temp_xx+1, temp_yy, temp_xx+1, 32, Fade(tempColor, fadePrimaryAmount));
+        canvasDrawLine(&canvas, temp_xx+2, temp_yy, temp_xx+2, 32, Fade(tempColor, fadePrimaryAmount));
+
+        canvasDrawPixel(&canvas, temp_xx, temp_yy,  Fade(tempColor, fadeSecondaryAmount));
+        canvasDrawPixel(&canvas, temp_xx+1, temp_yy,  Fade(tempColor, fadeSecondaryAmount));
+
+    };
+
+    // // mask out some edges of temp display
+    // canvasDrawLine(&canvas, 1,0,1,32, (Color){0,0,0,255});
+    // canvasDrawLine(&canvas, 0,0,0,32, (Color){0,0,0,255});
+
+    // draw icon on current temp
+    int timeOfDay_yy = 31 - (map(temperatures[0], minTemperature, maxTemperature, 1, tempDisplayHeight));
+    canvasDrawLine(&canvas, 19, 0, 19,  32, Fade(currentTempColor, 0.25f));
+
+    for (int i = 10; i >= 0.5; i = i * 0.8) {
+        // canvasDrawLine(&canvas, 19, timeOfDay_yy - i, 19,  timeOfDay_yy + i + 1, Fade(currentTempColor, 0.4f));
+        canvasDrawLine(&canvas, 19, timeOfDay_yy - i, 19,  timeOfDay_yy + i + 1, Fade(currentTempColor, (10 - i) / 10.0f));
+        canvasDrawLine(&canvas, 19 - (i/2), timeOfDay_yy, 19 + (i/2) + 1,  timeOfDay_yy, Fade(currentTempColor, (10 - i) / 10.0f));
+        // canvasDrawLine(&canvas, 19 - (i/2) -1, timeOfDay_yy- (i/2), 19 + (i/2) + 1,  timeOfDay_yy+ (i/2), Fade(currentTempColor, (10 - i) / 10.0f));
+        // canvasDrawLine(&canvas, 19 - (i/2) -1, timeOfDay_yy+ (i/2), 19 + (i/2) + 1,  timeOfDay_yy- (i/2), Fade(currentTempColor, (10 - i) / 10.0f));
+
+    }
+
+    // canvasDrawLine(&canvas, 19, timeOfDay_yy - 3, 19,  timeOfDay_yy + 4, Fade(currentTempColor, 0.75f));
+    // canvasDrawLine(&canvas, 19, timeOfDay_yy - 1, 19,  timeOfDay_yy + 2, Fade(currentTempColor, 0.75f));
+    // canvasDrawLine(&canvas, 19, timeOfDay_yy, 19,  timeOfDay_yy + 1, Fade(currentTempColor, 0.75f));
+
+    // canvasDrawRectangle(&canvas, 16, timeOfDay_yy - 2, 5,5, (Color){0,0,0,255});
+    // canvasDrawRectangle(&canvas, 17, timeOfDay_yy - 1, 3,3, (Color){128,128,128,255});
+    // canvasDrawRectangle(&canvas, 18, timeOfDay_yy, 1,1, (Color){0,0,0,255});
+
+    // Draw temperature
+    drawOutlinedText(&canvas, fmt::format("{}", temperatures[0]).c_str(), 2, 22, 2, (Color){0,0,0,255}, (Color){255,255,255,255});
+
+    //canvasDrawRectangle(&canvas, 0, 24, 64, 32, (Color){30,30,30,255});
+    int temperatureLength = MeasureText(fmt::format("{}", temperatures[0]).c_str(), 2);
+    canvasDrawRectangle(&canvas, 2 + temperatureLength, 22, 5,5, (Color){0,0,0,255});
+    canvasDrawRectangle(&canvas, 3 + temperatureLength, 23, 3,3, (Color){128,128,128,255});
+    canvasDrawRectangle(&canvas, 4 + temperatureLength, 24, 1,1, (Color){0,0,0,255});
+
+    // BeginBlendMode(BLEND_ADDITIVE);
+    // DrawTexturePro(targetSecondHandOverlay.texture, (Rectangle){ 0, 0, 64, -32 }, (Rectangle){ 0, 0, 64, 32 }, (Vector2){0,0}, 0.0f, WHITE);           
+    // EndBlendMode();
+
+    drawOutlinedText(&canvas, dateBuffer, 64 - MeasureText(dateBuffer, 5) - 2, 11, 2, (Color){0,0,0,255}, (Color){128,128,128,255});
+
+    // Reduce brightness at nighttime, fading through twilight
+    if (daylightSample.brightness < 255) {
+        unsigned char b = daylightSample.brightness;
+        canvasMultiply(&canvas, (Color){b,b,b,255});
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <cpr/cpr.h>
+#include "raylib.h"
+#include "solar.h"
+#include "timezone.h"
+
+typedef enum WeatherType
+{
+    full_sun = 1,
+    full_moon = 8,
+    partial_sun = 2,
+    partial_moon = 7,
+    cloudy = 3,
+    cloudy_rain = 4,
+    cloudy_snow = 5,
+    cloudy_thunder = 6
+} WeatherType;
+
+// One entry of resources/clocks.json
+typedef struct ClockConfig
+{
+    std::string name;
+    double latitude;
+    double longitude;
+    std::string timezone;
+    int panel; // Position in the panel chain, clocks sharing a panel take turns
+} ClockConfig;
+
+// Images and color tables shared by every clock, read-only once loaded
+typedef struct ClockAssets
+{
+    Image weatherIconCloud1;
+    Image weatherIconCloud2;
+    Image weatherIconCloud3;
+    Image weatherIconCloud4;
+    Image weatherIconSnow;
+    Image weatherIconMoonCloud1;
+    Image weatherIconSun;
+    Image weatherIconMoon;
+
+    // Temperature as integer degree F into a color
+    Color lookupColors[128];
+} ClockAssets;
+
+// Clock face for a single location, rendered into its own CPU-side image
+class ClockInstance {
+    public:
+        ClockInstance(const ClockConfig& config, int width, int height);
+        ~ClockInstance();
+
+        // Advances time, daylight and weather state. Only touches this instance,
+        // so instances can be updated in parallel from worker threads.
+        void update(uint64_t nowMillis);
+
+        // Draws the current state into this instance's image. Never calls into GL,
+        // so instances can also be rendered in parallel from worker threads.
+        void render(const ClockAssets& assets);
+
+        const Image& image() const;
+        const ClockConfig& config() const;
+
+    private:
+        ClockConfig clockConfig;
+        TimeZone timeZone;
+        SolarTimeline daylight;
+        Image canvas;
+        int width;
+        int height;
+
+        // Weather state
+        cpr::AsyncResponse pendingWeatherQuery;
+        uint64_t lastWeatherQuery;
+        int temperatures[24];
+        WeatherType weatherEnum;
+
+        // Frame state, filled in by update() for render()
+        char timeBuffer[256];
+        char timeBuffer2[256];
+        char timeBuffer3[256];
+        char dateBuffer[256];
+        int secondInDay;
+        DaylightSample daylightSample;
+        WeatherType weatherIcon;
+
+        void queryWeather();
+        void parseWeather(const cpr::Response& r);
+};
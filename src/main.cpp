@@ -1,86 +1,108 @@
 #include <iostream>
-#include <locale>
+#include <fstream>
 #include <chrono>
 #include <cstdint>
-#include <iomanip>
 #include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
 #include <fmt/core.h>
 #include "raylib.h"
 #include "matrix_driver.h"
+#include "clock_instance.h"
+#include "worker_pool.h"
+#include "canvas.h"
 #include <nlohmann/json.hpp>
-#include <cpr/cpr.h>
-#include <boost/algorithm/string.hpp>    
-#include <regex>
 
 using json = nlohmann::json;
 
+// Size of a single panel, each clock renders at this resolution
 const int texWidth = 64;
 const int texHeight = 32;
 
 const int screenZoomFactor = 10;
-const int screenWidth = texWidth * screenZoomFactor;
-const int screenHeight = texHeight * screenZoomFactor;
+
+const char* clockConfigPath = "resources/clocks.json";
+
+// Longest panel chain we will drive, guards against typos in the config
+const int maxPanelCount = 8;
 
 uint64_t timeSinceEpochMillisec() {
   using namespace std::chrono;
   return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
 }
 
-long map(long x, long in_min, long in_max, long out_min, long out_max) {
-  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
-}
-
-double seconds_since_local_midnight() {
-  time_t now;
-  if (time(&now) == -1) {
-    return -1;
-  }
-  struct tm timestamp;
-  if (localtime_r(&now, &timestamp) == 0) { // C23
-    return -1;
-  }
-  timestamp.tm_isdst = -1; // Important
-  timestamp.tm_hour = 0;
-  timestamp.tm_min = 0;
-  timestamp.tm_sec = 0;
-  time_t midnight = mktime(&timestamp);
-  if (midnight == -1) {
-    return -1;
-  }
-  return difftime(now, midnight);
+// Loads an image in the pixel format the canvas functions expect
+Image loadCanvasImage(const char* path) {
+    Image image = LoadImage(path);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    return image;
 }
 
-void drawOutlinedText(const char* text, int x, int y, int size, Color bg, Color fg) {
-    DrawText(text, x-1, y-1, size, bg);
-    DrawText(text, x-0, y-1, size, bg);
-    DrawText(text, x+1, y-1, size, bg);
-    DrawText(text, x-1, y-0, size, bg);
-    DrawText(text, x-0, y-0, size, bg);
-    DrawText(text, x+1, y-0, size, bg);
-    DrawText(text, x-1, y+1, size, bg);
-    DrawText(text, x-0, y+1, size, bg);
-    DrawText(text, x+1, y+1, size, bg);
+// Reads the set of clocks to show, falls back to a single clock if the config is missing or invalid
+std::vector<ClockConfig> loadClockConfigs(const char* path, int& rotateSeconds) {
+    std::vector<ClockConfig> configs;
+    rotateSeconds = 10;
+
+    std::ifstream file(path);
+    if (file) {
+        try {
+            json rawConfig = json::parse(file);
+            rotateSeconds = std::max(1, rawConfig.value("rotateSeconds", 10));
+            for (auto& rawClock : rawConfig["clocks"]) {
+                ClockConfig config;
+                config.name = rawClock.value("name", "");
+                config.latitude = rawClock["latitude"];
+                config.longitude = rawClock["longitude"];
+                config.timezone = rawClock.value("timezone", "UTC");
+                config.panel = rawClock.value("panel", 0);
+                if (config.panel < 0 || config.panel >= maxPanelCount) {
+                    std::cout << fmt::format("Skipping clock {}: panel {} is outside 0-{}", config.name, config.panel, maxPanelCount - 1) << std::endl;
+                    continue;
+                }
+                configs.push_back(config);
+            }
+        } catch (std::exception &e) {
+            std::cout << "Failed to parse clock config!" << e.what() << std::endl;
+            configs.clear();
+        }
+    } else {
+        std::cout << "No clock config found at " << path << std::endl;
+    }
 
-    DrawText(text, x, y, size, fg);
+    if (configs.empty()) {
+        configs.push_back({"Boston", 42.39, -71.10, "America/New_York", 0});
+    }
+    return configs;
 }
 
-typedef enum WeatherType
-{
-    full_sun = 1,
-    full_moon = 8,
-    partial_sun = 2,
-    partial_moon = 7,
-    cloudy = 3,
-    cloudy_rain = 4,
-    cloudy_snow = 5,
-    cloudy_thunder = 6
-} WeatherType;
-
 int main(int argc, char** argv) {
+    int rotateSeconds;
+    std::vector<ClockConfig> clockConfigs = loadClockConfigs(clockConfigPath, rotateSeconds);
+
+    // Panels are chained left to right, clocks sharing a panel rotate every rotateSeconds.
+    // Unused panel numbers are closed up so gaps in the config don't leave black panels.
+    std::vector<int> usedPanels;
+    for (auto& config : clockConfigs) {
+        usedPanels.push_back(config.panel);
+    }
+    std::sort(usedPanels.begin(), usedPanels.end());
+    usedPanels.erase(std::unique(usedPanels.begin(), usedPanels.end()), usedPanels.end());
+    for (auto& config : clockConfigs) {
+        int panel = std::lower_bound(usedPanels.begin(), usedPanels.end(), config.panel) - usedPanels.begin();
+        if (panel != config.panel) {
+            std::cout << fmt::format("Moving clock {} from panel {} to panel {}", config.name, config.panel, panel) << std::endl;
+            config.panel = panel;
+        }
+    }
+    int panelCount = usedPanels.size();
+    int chainWidth = texWidth * panelCount;
+    int screenWidth = chainWidth * screenZoomFactor;
+    int screenHeight = texHeight * screenZoomFactor;
+
     InitWindow(screenWidth, screenHeight, "LED Matrix Clock");
-    RenderTexture2D target = LoadRenderTexture(texWidth, texHeight);
-    RenderTexture2D targetSecondHandOverlay = LoadRenderTexture(texWidth, texHeight);
-    MatrixDriver matrixDriver(&argc, &argv, texWidth, texHeight);
+    MatrixDriver matrixDriver(&argc, &argv, chainWidth, texHeight);
 
     if (matrixDriver.isShim()) {
         SetTargetFPS(30);
@@ -88,68 +110,44 @@ int main(int argc, char** argv) {
         SetTargetFPS(5);
     }
 
-
-    int x = 0;
-    int y = 0;
-    int velX = 1;
-    int velY = 1;
-
-    
-    char timeBuffer[256];
-    char timeBuffer2[256];
-    char timeBuffer3[256];
-    char dateBuffer[256];
-
-    int temperatures[24];
-    int minTemperature = 60;
-    int maxTemperature = 80;
-
-    int tempDisplayHeight = 10;
-
-    for (int i = 0; i < 24; i++) {
-        temperatures[i] = 60;
-    }
-    uint64_t lastWeatherQuery = 0;
-    json jsonWeatherData;
+    // Clocks render on the CPU into this image, it is only uploaded to the GPU for the debug window
+    Image chainImage = canvasCreate(chainWidth, texHeight);
+    Texture2D chainTexture = LoadTextureFromImage(chainImage);
 
     bool dimMode = false;
     bool dimModeLatch = false;
 
-    std::regex rainRegex("rain");
-    std::regex snowRegex("snow");
-    std::regex chanceOfRegex("chance");
-    std::regex thunderRegex("thunder");
-    std::regex cloudyRegex("cloudy");
-    std::regex clearRegex("clear");
-    std::regex partlyRegex("partly");
-
     // Texture2D dayBg = LoadTextureFromImage(GenImageGradientV(texWidth, texHeight, (Color){0, 0, 0,255}, (Color){43, 169, 252,255}));
     // Texture2D parallaxBgImg = LoadTexture("resources/bg.png");
-    WeatherType weatherEnum = WeatherType::full_sun;
-
 
-    Texture2D weatherIconCloud1 = LoadTexture("resources/weather-icon-cloud-1.png");
-    Texture2D weatherIconCloud2 = LoadTexture("resources/weather-icon-cloud-2.png");
-    Texture2D weatherIconCloud3 = LoadTexture("resources/weather-icon-cloud-3.png");
-    Texture2D weatherIconCloud4 = LoadTexture("resources/weather-icon-cloud-4.png");
-    Texture2D weatherIconSnow = LoadTexture("resources/weather-icon-snow.png");
-    Texture2D weatherIconMoonCloud1 = LoadTexture("resources/weather-icon-moon-cloud-1.png");
-    Texture2D weatherIconSun = LoadTexture("resources/weather-icon-sun.png");
-    Texture2D weatherIconMoon = LoadTexture("resources/weather-icon-moon.png");
-
-    float timeOfDayPercent = 0.0f;
+    ClockAssets assets;
+    assets.weatherIconCloud1 = loadCanvasImage("resources/weather-icon-cloud-1.png");
+    assets.weatherIconCloud2 = loadCanvasImage("resources/weather-icon-cloud-2.png");
+    assets.weatherIconCloud3 = loadCanvasImage("resources/weather-icon-cloud-3.png");
+    assets.weatherIconCloud4 = loadCanvasImage("resources/weather-icon-cloud-4.png");
+    assets.weatherIconSnow = loadCanvasImage("resources/weather-icon-snow.png");
+    assets.weatherIconMoonCloud1 = loadCanvasImage("resources/weather-icon-moon-cloud-1.png");
+    assets.weatherIconSun = loadCanvasImage("resources/weather-icon-sun.png");
+    assets.weatherIconMoon = loadCanvasImage("resources/weather-icon-moon.png");
 
     // Convert temperature as integer degree F into a table of colors
-    Texture2D temperatureScaleImg = LoadTexture("resources/temperature-scale.png");
-    Image colorLookupTable = LoadImageFromTexture(temperatureScaleImg);
-    Color lookupColors[128];
+    Image colorLookupTable = LoadImage("resources/temperature-scale.png");
     for (int i = 0; i < 128; i++) {
-        lookupColors[i] = GetImageColor(colorLookupTable, 0, i);
+        assets.lookupColors[i] = GetImageColor(colorLookupTable, 0, i);
+    }
+    UnloadImage(colorLookupTable);
+
+    std::vector<std::unique_ptr<ClockInstance>> clocks;
+    std::vector<std::vector<int>> panels(panelCount);
+    for (auto& config : clockConfigs) {
+        clocks.push_back(std::make_unique<ClockInstance>(config, texWidth, texHeight));
+        panels[config.panel].push_back(clocks.size() - 1);
     }
 
-    int secondInDay = seconds_since_local_midnight();
-    int sunriseSecondsTime = 5 * 60 * 60;
-    int sunsetSecondsTime = 20 * 60 * 60;
+    // The main thread takes jobs too, so one worker per remaining core
+    int coreCount = std::max(1u, std::thread::hardware_concurrency());
+    WorkerPool workerPool(std::min((int)clocks.size(), coreCount) - 1);
+    std::cout << fmt::format("Rendering {} clocks on {} panels with {} workers", clocks.size(), panelCount, workerPool.size()) << std::endl;
 
     /*
     - ring with sun, moon, sunset, stars, etc as base layer
@@ -167,151 +165,6 @@ int main(int argc, char** argv) {
      */
 
     while (!WindowShouldClose()) {
-        // Query weather data if it is expired
-        if (timeSinceEpochMillisec() - lastWeatherQuery > 60000) {
-            std::cout << "Querying weather API..." << std::endl;
-            lastWeatherQuery = timeSinceEpochMillisec();
-
-            // Grab forecast from API call
-            cpr::Response r = cpr::Get(
-                cpr::Url{"https://api.open-meteo.com/v1/forecast?latitude=42.39&longitude=-71.10&hourly=temperature_2m,weathercode&timezone=America/New_York&current_weather=true&temperature_unit=fahrenheit&timeformat=unixtime&daily=sunrise,sunset"});
-
-
-
-
-            if (r.status_code == 200) {
-                try {
-                    json rawPayload = json::parse(r.text);
-                    //std::cout << rawPayload.dump(4) << std::endl;
-
-                    auto& currentWeather = rawPayload["current_weather"];
-
-                    std::vector<double> temperatureData = rawPayload["hourly"]["temperature_2m"];
-                    std::vector<uint64_t> timestamps = rawPayload["hourly"]["time"];
-
-                    // Find the next 24 temperature and forecast values
-                    int i = 0;
-                    for (auto& ts: timestamps) {
-                        if (ts >= (lastWeatherQuery / 1000)) {
-                            int hourRelative = (int)((ts - (lastWeatherQuery / 1000)) / 3600.0);
-                            double temperature = temperatureData[i];
-                            if (hourRelative < 24) {
-                                std::cout << "Hour: " << hourRelative << "Temp: " << temperature << std::endl;
-                                temperatures[hourRelative] = temperature;
-                            }
-                        }
-                        i += 1;
-                    }
-
-                    temperatures[0] = currentWeather["temperature"];
-                    int currentWeatherCode = currentWeather["weathercode"];
-                    uint64_t currentSunrise = rawPayload["daily"]["sunrise"][0];
-                    uint64_t currentSunset = rawPayload["daily"]["sunset"][0];
-
-                    currentSunrise *= 1000;
-                    currentSunset *= 1000;
-
-                    std::cout << "Sunrise today: " << currentSunrise << std::endl;
-                    std::cout << "Sunset today: " << currentSunset << std::endl;
-                    std::cout << "Current time: " << lastWeatherQuery << std::endl;
-
-                    bool isDaytime = false;
-                    if (lastWeatherQuery > (currentSunrise)) {
-                        // After sunrise
-                        isDaytime = true;
-                    }
-                    if (lastWeatherQuery > (currentSunset)) {
-                        // After sunset
-                        isDaytime = false;
-                    }
-
-                    std::cout << "Is daytime: " << isDaytime << std::endl;
-                    std::cout << "Current weather code: " << currentWeatherCode << std::endl;
-                    std::cout << "Current temperature: " << temperatures[0] << std::endl;
-
-                    // Weather codes at bottom of https://open-meteo.com/en/docs
-                    /*
-                    typedef enum WeatherType
-                    {
-                        full_sun = 1,
-                        full_moon = 8,
-                        partial_sun = 2,
-                        partial_moon = 7,
-                        cloudy = 3,
-                        cloudy_rain = 4,
-                        cloudy_snow = 5,
-                        cloudy_thunder = 6
-                    } WeatherType;
-                    */
-                    if (currentWeatherCode == 0 || currentWeatherCode == 1) {
-                        // Clear sky, mainly clear
-                        if (isDaytime) {
-                            weatherEnum = WeatherType::full_sun;
-                        } else {
-                            weatherEnum = WeatherType::full_moon;
-                        }
-                    } else if (currentWeatherCode == 2) {
-                        // Partly cloudy
-                        if (isDaytime) {
-                            weatherEnum = WeatherType::partial_sun;
-                        } else {
-                            weatherEnum = WeatherType::partial_moon;
-                        }
-                    } else if (
-                        currentWeatherCode == 3 || 
-                        currentWeatherCode == 45 || 
-                        currentWeatherCode == 48) {
-                        // Overcast, fog
-                        weatherEnum = WeatherType::cloudy;
-                    } else if (
-                        currentWeatherCode == 51 || 
-                        currentWeatherCode == 53 || 
-                        currentWeatherCode == 55 || 
-                        currentWeatherCode == 56 ||
-                        currentWeatherCode == 57 ||
-                        currentWeatherCode == 61 || 
-                        currentWeatherCode == 63 ||
-                        currentWeatherCode == 65 ||
-                        currentWeatherCode == 66 ||
-                        currentWeatherCode == 67 || 
-                        currentWeatherCode == 80 ||
-                        currentWeatherCode == 81 ||
-                        currentWeatherCode == 82) {
-                        // raining
-                        weatherEnum = WeatherType::cloudy_rain;
-                    } else if (
-                        currentWeatherCode == 71 ||
-                        currentWeatherCode == 73 ||
-                        currentWeatherCode == 75 ||
-                        currentWeatherCode == 77 ||
-                        currentWeatherCode == 85 ||
-                        currentWeatherCode == 86) {
-                        // snowing
-                        weatherEnum = WeatherType::cloudy_snow;
-                    } else if (
-                        currentWeatherCode == 95 ||
-                        currentWeatherCode == 96 ||
-                        currentWeatherCode == 99) {
-                        // thundering
-                        weatherEnum = WeatherType::cloudy_thunder;
-                    } else {
-                        // Default: partial sun or moon
-                        if (isDaytime) {
-                            weatherEnum = WeatherType::partial_sun;
-                        } else {
-                            weatherEnum = WeatherType::partial_moon;
-                        }
-                    }
-
-                } catch (std::exception &e) {
-                    std::cout << "Failed to parse weather API!" << e.what() << std::endl;
-                }
-            } else {
-                std::cout << "Failed to query weather API! Status code: " << r.status_code << "msg: " << r.text << std::endl;
-            }
-        }
-        secondInDay = seconds_since_local_midnight();
-
         // Debug: toggle brightness
         // On real device this is done with the hardware button
         if (IsKeyDown(32) || matrixDriver.hardwareSwitchPressed()) {
@@ -326,238 +179,52 @@ int main(int argc, char** argv) {
             dimModeLatch = false;
         }
 
-        std::time_t now = std::time(nullptr);
-        std::strftime(timeBuffer, 256, "%I:%M%p", std::localtime(&now));
-        std::strftime(timeBuffer2, 256, "%I:%M", std::localtime(&now));
-        std::strftime(timeBuffer3, 256, "%M%p", std::localtime(&now));
-        std::strftime(dateBuffer, 256, "%b %e", std::localtime(&now));
-        // Handle updating clock state!
-
-        timeOfDayPercent = ((timeSinceEpochMillisec() / 100) % 1000) / 1000.0f;
- 
-        BeginDrawing();
-
-
-        BeginTextureMode(targetSecondHandOverlay);
-        ClearBackground((Color){0, 0, 0, 100});
-
-        auto time = std::localtime(&now);
-
-        float secPercent = time->tm_sec / 60.0f;
-        float hourPercent = time->tm_hour / 12.0f;
-        float minPercent = time->tm_min / 60.0f;
-        // float startAngle = 245.0f - (minPercent * 360.0f);
-        // float endAngle = 245.0f;
-        // DrawCircleSector((Vector2){32, 16}, 48.0f, startAngle, endAngle, 256, (Color){255,255,255,32});
-        // DrawCircleSector((Vector2){32, 16}, 48.0f, startAngle, startAngle + 10.0f, 256, (Color){255,255,255,255});
-
-        float secondAngleRad = ((secPercent * 360.0f) - 90.0f) * (PI/180.0f);
-        float minuteAngleRad = ((minPercent * 360.0f) - 90.0f) * (PI/180.0f);
-        float hourAngleRad = ((hourPercent * 360.0f) - 90.0f) * (PI/180.0f);
-        DrawLineEx((Vector2){32, 16}, (Vector2){32.0f + cos(hourAngleRad) * 100.0f, 16.0f + sin(hourAngleRad) * 100.0f}, 2.0f, (Color){255,255,255,215});
-        DrawRectangle(1,1,62, 30, (Color){0,0,0,40});
-        DrawLineEx((Vector2){32, 16}, (Vector2){32.0f + cos(minuteAngleRad) * 100.0f, 16.0f + sin(minuteAngleRad) * 100.0f}, 2.0f, (Color){255,255,255,235});
-        DrawRectangle(1,1,62, 30, (Color){0,0,0,40});
-        DrawLineEx((Vector2){32, 16}, (Vector2){32.0f + cos(secondAngleRad) * 100.0f, 16.0f + sin(secondAngleRad) * 100.0f}, 2.0f, (Color){255,255,255,255});
-        DrawRectangle(1,1,62, 30, (Color){0,0,0,230});
-
-
-
-
-        EndTextureMode();
-
-        // Render to internal buffer of same resolution as physical screen
-        BeginTextureMode(target);
-
-        // DrawTexture(dayBg, 0, 0, (Color){255,255,255,255});
-        ClearBackground((Color){0, 0, 0, 255});
-
-        // dither
-
-        Color currentTempColor = (Color){255,255,255,255};
-        if (temperatures[0] < 0) {
-            currentTempColor = (Color){255,255,255,255};
-        } else if (temperatures[0] >= 128) {
-            currentTempColor = (Color){255,50,50,255};
-        } else {
-            // Valid lookup
-            currentTempColor = lookupColors[temperatures[0]];
-        }
-
-        for (int x = -1; x < 19; x++) {
-            for (int y = -1; y < 32; y++) {
-                if ((x+y) % 2) {
-                    DrawPixel(x, y, Fade(currentTempColor, 0.3f));
-                }
-            }
-        }
-
-        // Draw background parallax tex
-        // DrawTexturePro(parallaxBgImg, (Rectangle){ 0, 0, 192,192 }, (Rectangle){32, 90, 192, 192}, (Vector2){96,96}, timeOfDayPercent * 360, WHITE); 
-
-        // Draw time and date
-        drawOutlinedText(timeBuffer, 64 - MeasureText(timeBuffer, 5) - 2, 1, 5, (Color){0,0,0,255}, (Color){255,255,255,255});
-        drawOutlinedText(dateBuffer, 64 - MeasureText(dateBuffer, 5) - 2, 11, 2, (Color){0,0,0,255}, (Color){255,255,255,255});
-
-        // make everything rendered before this half as bright
-        DrawRectangle(0, 0, 64, 32, (Color){0,0,0,128});
-
-        // Draw weather icon
-        if (weatherEnum == WeatherType::full_sun) {
-            DrawTexture(weatherIconSun, 1, 11, (Color){255,255,255,255});
-        } else if (weatherEnum == WeatherType::partial_sun) {
-            DrawTexture(weatherIconCloud1, 1, 11, (Color){255,255,255,255});
-        } else if (weatherEnum == WeatherType::cloudy) {
-            DrawTexture(weatherIconCloud2, 1, 11, (Color){255,255,255,255});
-        } else if (weatherEnum == WeatherType::cloudy_rain) {
-            DrawTexture(weatherIconCloud3, 1, 11, (Color){255,255,255,255});
-        } else if (weatherEnum == WeatherType::cloudy_snow) {
-            DrawTexture(weatherIconSnow, 1, 11, (Color){255,255,255,255});
-        } else if (weatherEnum == WeatherType::cloudy_thunder) {
-            DrawTexture(weatherIconCloud4, 1, 11, (Color){255,255,255,255});
-        } else if (weatherEnum == WeatherType::partial_moon) {
-            DrawTexture(weatherIconMoonCloud1, 1, 11, (Color){255,255,255,255});
-        } else if (weatherEnum == WeatherType::full_moon) {
-            DrawTexture(weatherIconMoon, 1, 11, (Color){255,255,255,255});
-        } else {
-            DrawTexture(weatherIconCloud2, 1, 11, (Color){255,255,255,255});
+        // Pick the clock showing on each panel
+        uint64_t nowMillis = timeSinceEpochMillisec();
+        uint64_t rotation = (nowMillis / 1000) / rotateSeconds;
+        std::vector<int> clockPanels(clocks.size(), -1);
+        for (int i = 0; i < panelCount; i++) {
+            clockPanels[panels[i][rotation % panels[i].size()]] = i;
         }
 
-        
-        drawOutlinedText(timeBuffer2, 64 - MeasureText(timeBuffer, 5) - 2, 1, 5, (Color){0,0,0,255}, (Color){255,255,255,255});
-        
-        if (secondInDay % 2 == 0) {
-            DrawRectangle(64 - MeasureText(timeBuffer3, 5) - 4, 0, 1, 12, (Color){0,0,0,255});
-        }
-
-        // find max and min temperatures
-        minTemperature = 999;
-        maxTemperature = -999;
-        for (int i = 0; i < 24; i++) {
-            if (temperatures[i] < minTemperature) {
-                minTemperature = temperatures[i];
-            }
-            if (temperatures[i] > maxTemperature) {
-                maxTemperature = temperatures[i];
-            }
-        }
-        int tempRange = (maxTemperature - minTemperature);
-        if (tempRange < 10) {
-            int centerTemp = (maxTemperature + minTemperature) / 2;
-            minTemperature = centerTemp - 5;
-            maxTemperature = centerTemp + 5;
-        }
-
-        // DrawRectangle(0, 0, 1, 1, (Color){0,0,255,255});
-
-        // Draw temperature line for the current day
-        for (int i = 0; i < 24; i++) {
-            int temp_xx = 19 + (i*2);
-            int temp = temperatures[i];
-            int temp_yy = 31 - (map(temp, minTemperature, maxTemperature, 1, tempDisplayHeight));
-
-            Color tempColor = (Color){255,255,255,255};
-            if (temp < 0) {
-                tempColor = (Color){255,255,255,255};
-            } else if (temp >= 128) {
-                tempColor = (Color){255,50,50,255};
-            } else {
-                // Valid lookup
-                tempColor = lookupColors[temp];
+        // Handle updating clock state!
+        // Each visible clock renders and places itself on its own slice of the chain,
+        // so the only shared state is read-only assets.
+        workerPool.parallelFor(clocks.size(), [&](int i) {
+            clocks[i]->update(nowMillis);
+            int panel = clockPanels[i];
+            if (panel < 0) {
+                return;
             }
-
-            float fadePrimaryAmount = 0.25f;
-            float fadeSecondaryAmount = 0.6f;
-
-            int secondTime = i * 60 * 60;
-            // if (secondTime <= sunriseSecondsTime || secondTime >= sunsetSecondsTime) {
-            //     // Nighttime
-            //     fadePrimaryAmount = 0.1f;
-            //     fadeSecondaryAmount = 0.05f;
-            // }
-
-            DrawLine(temp_xx+1, temp_yy, temp_xx+1, 32, Fade(tempColor, fadePrimaryAmount));
-            DrawLine(temp_xx+2, temp_yy, temp_xx+2, 32, Fade(tempColor, fadePrimaryAmount));
-
-            DrawPixel(temp_xx, temp_yy,  Fade(tempColor, fadeSecondaryAmount));
-            DrawPixel(temp_xx+1, temp_yy,  Fade(tempColor, fadeSecondaryAmount));
-
-        };
-
-        // // mask out some edges of temp display
-        // DrawLine(1,0,1,32, (Color){0,0,0,255});
-        // DrawLine(0,0,0,32, (Color){0,0,0,255});
-
-        // draw icon on current temp
-        int timeOfDay_yy = 31 - (map(temperatures[0], minTemperature, maxTemperature, 1, tempDisplayHeight));
-        DrawLine(19, 0, 19,  32, Fade(currentTempColor, 0.25f));
-
-        for (int i = 10; i >= 0.5; i = i * 0.8) {
-            // DrawLine(19, timeOfDay_yy - i, 19,  timeOfDay_yy + i + 1, Fade(currentTempColor, 0.4f));
-            DrawLine(19, timeOfDay_yy - i, 19,  timeOfDay_yy + i + 1, Fade(currentTempColor, (10 - i) / 10.0f));
-            DrawLine(19 - (i/2), timeOfDay_yy, 19 + (i/2) + 1,  timeOfDay_yy, Fade(currentTempColor, (10 - i) / 10.0f));
-            // DrawLine(19 - (i/2) -1, timeOfDay_yy- (i/2), 19 + (i/2) + 1,  timeOfDay_yy+ (i/2), Fade(currentTempColor, (10 - i) / 10.0f));
-            // DrawLine(19 - (i/2) -1, timeOfDay_yy+ (i/2), 19 + (i/2) + 1,  timeOfDay_yy- (i/2), Fade(currentTempColor, (10 - i) / 10.0f));
-
-        }
-
-        // DrawLine(19, timeOfDay_yy - 3, 19,  timeOfDay_yy + 4, Fade(currentTempColor, 0.75f));
-        // DrawLine(19, timeOfDay_yy - 1, 19,  timeOfDay_yy + 2, Fade(currentTempColor, 0.75f));
-        // DrawLine(19, timeOfDay_yy, 19,  timeOfDay_yy + 1, Fade(currentTempColor, 0.75f));
-
-        // DrawRectangle(16, timeOfDay_yy - 2, 5,5, (Color){0,0,0,255});
-        // DrawRectangle(17, timeOfDay_yy - 1, 3,3, (Color){128,128,128,255});
-        // DrawRectangle(18, timeOfDay_yy, 1,1, (Color){0,0,0,255});
-
-        // Draw temperature
-        drawOutlinedText(fmt::format("{}", temperatures[0]).c_str(), 2, 22, 2, (Color){0,0,0,255}, (Color){255,255,255,255});
-
-        //DrawRectangle(0, 24, 64, 32, (Color){30,30,30,255});
-        int temperatureLength = MeasureText(fmt::format("{}", temperatures[0]).c_str(), 2);
-        DrawRectangle(2 + temperatureLength, 22, 5,5, (Color){0,0,0,255});
-        DrawRectangle(3 + temperatureLength, 23, 3,3, (Color){128,128,128,255});
-        DrawRectangle(4 + temperatureLength, 24, 1,1, (Color){0,0,0,255});
-
-        // BeginBlendMode(BLEND_ADDITIVE);
-        // DrawTexturePro(targetSecondHandOverlay.texture, (Rectangle){ 0, 0, 64, -32 }, (Rectangle){ 0, 0, 64, 32 }, (Vector2){0,0}, 0.0f, WHITE);           
-        // EndBlendMode();
-
-        drawOutlinedText(dateBuffer, 64 - MeasureText(dateBuffer, 5) - 2, 11, 2, (Color){0,0,0,255}, (Color){128,128,128,255});
-
-        // Reduce brightness at nighttime
-        if ((secondInDay < (7 * 60 * 60) || (secondInDay > (22 * 60 * 60)))) {
-            BeginBlendMode(BLEND_MULTIPLIED);
-            DrawRectangle(0,0,texWidth,texHeight, (Color){128,128,128,255});
-            EndBlendMode();
-        }
+            clocks[i]->render(assets);
+            canvasCopy(&chainImage, clocks[i]->image(), panel * texWidth, 0);
+        });
 
         if (dimMode) {
-            BeginBlendMode(BLEND_MULTIPLIED);
-            DrawRectangle(0,0,texWidth,texHeight, (Color){64,64,64,255});
-            EndBlendMode();
+            canvasMultiply(&chainImage, (Color){64,64,64,255});
         }
 
-        EndTextureMode();
-
         // Draw a debug UI on the software window
+        UpdateTexture(chainTexture, chainImage.data);
+        BeginDrawing();
         ClearBackground((Color){0, 0, 0, 255});
-        DrawTexturePro(target.texture, (Rectangle){ 0, 0, texWidth, -texHeight }, (Rectangle){ 0, 0, screenWidth, screenHeight }, (Vector2){0,0}, 0.0f, WHITE); 
-
+        DrawTexturePro(chainTexture, (Rectangle){ 0, 0, (float)chainWidth, texHeight }, (Rectangle){ 0, 0, (float)screenWidth, (float)screenHeight }, (Vector2){0,0}, 0.0f, WHITE); 
         EndDrawing();
 
-        // Grab each pixel in the texture and render to the LED matrix
-        // canvas->Clear();
-        Image canvasImage = LoadImageFromTexture(target.texture);
-        for (int xx = 0; xx < texWidth; xx++) {
+        // Copy each pixel of the chain to the LED matrix
+        Color* pixels = (Color*)chainImage.data;
+        for (int xx = 0; xx < chainWidth; xx++) {
             for (int yy = 0; yy < texHeight; yy++) {
-                Color pix = GetImageColor(canvasImage, xx, yy);
-                matrixDriver.writePixel(xx, texHeight - yy - 1, pix.r, pix.g, pix.b);
+                Color pix = pixels[yy * chainWidth + xx];
+                matrixDriver.writePixel(xx, yy, pix.r, pix.g, pix.b);
             }
         }
         matrixDriver.flipBuffer();
-        UnloadImage(canvasImage);
     }
 
+    clocks.clear();
+    UnloadTexture(chainTexture);
+    UnloadImage(chainImage);
     CloseWindow();
     return 0;
-}
+}
\ No newline at end of file
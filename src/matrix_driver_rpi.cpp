@@ -2,6 +2,7 @@
 #include "led-matrix.h"
 #include "graphics.h"
 #include <unistd.h>
+#include <cstdlib>
 #include <wiringPi.h>
 
 using rgb_matrix::RGBMatrix;
@@ -26,7 +27,11 @@ MatrixDriver::MatrixDriver(int* argc, char **argv[], int _width, int _height) {
     matrix_options.hardware_mapping = "adafruit-hat-pwm";
     matrix_options.rows = 32;
     matrix_options.cols = 64;
-    matrix_options.chain_length = 1;
+    if (_width % matrix_options.cols != 0) {
+        std::cout << fmt::format("Matrix width {} is not a multiple of the panel width {}", _width, matrix_options.cols) << std::endl;
+        exit(1);
+    }
+    matrix_options.chain_length = _width / matrix_options.cols;
     matrix_options.parallel = 1;
     matrix_options.brightness = 100;
     matrix_options.pwm_dither_bits = 1;
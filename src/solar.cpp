@@ -0,0 +1,142 @@
+#include "solar.h"
+#include <cmath>
+
+const double degToRad = M_PI / 180.0;
+const double radToDeg = 180.0 / M_PI;
+
+// Sun elevation at sunrise/sunset, accounts for refraction and the solar disc radius
+const double horizonElevation = -0.833;
+
+// Low-precision solar position from the Astronomical Almanac, good to ~0.01 degrees
+// between 1950 and 2050, which is far more than a 64x32 panel needs.
+double solar_elevation(double latitude, double longitude, time_t timestamp) {
+    // Days since J2000.0
+    double n = (timestamp / 86400.0) + 2440587.5 - 2451545.0;
+
+    double meanLongitude = fmod(280.460 + 0.9856474 * n, 360.0);
+    double meanAnomaly = fmod(357.528 + 0.9856003 * n, 360.0) * degToRad;
+    double eclipticLongitude = (meanLongitude
+        + 1.915 * sin(meanAnomaly)
+        + 0.020 * sin(2.0 * meanAnomaly)) * degToRad;
+    double obliquity = (23.439 - 0.0000004 * n) * degToRad;
+
+    double rightAscension = atan2(cos(obliquity) * sin(eclipticLongitude), cos(eclipticLongitude));
+    double declination = asin(sin(obliquity) * sin(eclipticLongitude));
+
+    double siderealTime = fmod(280.46061837 + 360.98564736629 * n + longitude, 360.0) * degToRad;
+    double hourAngle = siderealTime - rightAscension;
+
+    double lat = latitude * degToRad;
+    return asin(sin(lat) * sin(declination) + cos(lat) * cos(declination) * cos(hourAngle))
+        * radToDeg;
+}
+
+static DaylightSample sample_for_elevation(double elevation) {
+    DaylightSample sample;
+    sample.elevation = elevation;
+
+    if (elevation > horizonElevation) {
+        sample.phase = SolarPhase::day;
+    } else if (elevation > -6.0) {
+        sample.phase = SolarPhase::civil_twilight;
+    } else if (elevation > -12.0) {
+        sample.phase = SolarPhase::nautical_twilight;
+    } else if (elevation > -18.0) {
+        sample.phase = SolarPhase::astronomical_twilight;
+    } else {
+        sample.phase = SolarPhase::night;
+    }
+
+    // Half brightness at night, ramping up to full brightness through civil and nautical twilight
+    double t = (elevation + 12.0) / 12.0;
+    if (t < 0.0) {
+        t = 0.0;
+    } else if (t > 1.0) {
+        t = 1.0;
+    }
+    sample.brightness = 128 + (unsigned char)(127 * t);
+
+    // Background tint, a faint glow around dawn and dusk
+    switch (sample.phase) {
+        case SolarPhase::civil_twilight:
+            sample.tintR = 20;
+            sample.tintG = 8;
+            sample.tintB = 2;
+            break;
+        case SolarPhase::nautical_twilight:
+            sample.tintR = 2;
+            sample.tintG = 2;
+            sample.tintB = 12;
+            break;
+        case SolarPhase::astronomical_twilight:
+            sample.tintR = 0;
+            sample.tintG = 0;
+            sample.tintB = 6;
+            break;
+        default:
+            sample.tintR = 0;
+            sample.tintG = 0;
+            sample.tintB = 0;
+            break;
+    }
+
+    return sample;
+}
+
+SolarTimeline::SolarTimeline(double _latitude, double _longitude) {
+    this->latitude = _latitude;
+    this->longitude = _longitude;
+    this->midnight = -1;
+    this->sunrise = -1;
+    this->sunset = -1;
+}
+
+void SolarTimeline::update(time_t localMidnight) {
+    if (localMidnight == midnight) {
+        return;
+    }
+    midnight = localMidnight;
+    sunrise = -1;
+    sunset = -1;
+
+    double prevElevation = solar_elevation(latitude, longitude, midnight);
+    for (int i = 0; i < samplesPerDay; i++) {
+        double elevation = solar_elevation(latitude, longitude, midnight + (i * 60));
+        samples[i] = sample_for_elevation(elevation);
+
+        // Interpolate horizon crossings to the second
+        if (i > 0) {
+            double crossing = (horizonElevation - prevElevation) / (elevation - prevElevation);
+            if (prevElevation <= horizonElevation && elevation > horizonElevation && sunrise < 0) {
+                sunrise = (i - 1) * 60 + (int)(crossing * 60);
+            }
+            if (prevElevation > horizonElevation && elevation <= horizonElevation) {
+                sunset = (i - 1) * 60 + (int)(crossing * 60);
+            }
+        }
+        prevElevation = elevation;
+    }
+}
+
+const DaylightSample& SolarTimeline::at(int secondInDay) const {
+    int i = secondInDay / 60;
+    if (i < 0) {
+        i = 0;
+    } else if (i >= samplesPerDay) {
+        // DST days can run past 24 hours
+        i = samplesPerDay - 1;
+    }
+    return samples[i];
+}
+
+bool SolarTimeline::isDaytime(int secondInDay) const {
+    return at(secondInDay).phase == SolarPhase::day;
+}
+
+int SolarTimeline::sunriseSecondsTime() const {
+    return sunrise;
+}
+
+int SolarTimeline::sunsetSecondsTime() const {
+    return sunset;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <ctime>
+
+// Sun phases ordered from darkest to brightest
+typedef enum SolarPhase
+{
+    night = 0,
+    astronomical_twilight = 1,
+    nautical_twilight = 2,
+    civil_twilight = 3,
+    day = 4
+} SolarPhase;
+
+typedef struct DaylightSample
+{
+    SolarPhase phase;
+    float elevation;          // Sun elevation in degrees
+    unsigned char brightness; // Multiplier applied to the whole frame, 255 = full brightness
+    unsigned char tintR;
+    unsigned char tintG;
+    unsigned char tintB;
+} DaylightSample;
+
+// Sun elevation in degrees for a location at a given UTC timestamp
+double solar_elevation(double latitude, double longitude, time_t timestamp);
+
+// Precomputed table of sun position for one local day, one sample per minute.
+// Rebuilt once per day so per-frame daylight logic is a table lookup.
+class SolarTimeline {
+    public:
+        static const int samplesPerDay = 24 * 60;
+
+        SolarTimeline(double latitude, double longitude);
+
+        // Rebuild the table for the day starting at localMidnight (UTC timestamp).
+        // Does nothing if the table already covers that day.
+        void update(time_t localMidnight);
+
+        const DaylightSample& at(int secondInDay) const;
+        bool isDaytime(int secondInDay) const;
+
+        // Seconds since local midnight, or -1 if the sun does not rise/set today
+        int sunriseSecondsTime() const;
+        int sunsetSecondsTime() const;
+
+    private:
+        double latitude;
+        double longitude;
+        time_t midnight;
+        int sunrise;
+        int sunset;
+        DaylightSample samples[samplesPerDay];
+};
@@ -0,0 +1,335 @@
+#include "timezone.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fmt/core.h>
+
+const char* zoneInfoPath = "/usr/share/zoneinfo/";
+
+static int64_t read_be(const std::vector<unsigned char>& data, size_t pos, int size) {
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value = (value << 8) | data[pos + i];
+    }
+    // Sign extend
+    if (size < 8 && (value & (1ULL << (size * 8 - 1)))) {
+        value |= ~0ULL << (size * 8);
+    }
+    return (int64_t)value;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date, from
+// https://howardhinnant.github.io/date_algorithms.html#days_from_civil
+static int64_t days_from_civil(int64_t y, int m, int d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static bool is_leap_year(int64_t y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static int days_in_month(int64_t y, int m) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (m == 2 && is_leap_year(y)) {
+        return 29;
+    }
+    return days[m - 1];
+}
+
+// Parses [+-]hh[:mm[:ss]]
+static bool parse_time(const char*& p, int& seconds) {
+    int sign = 1;
+    if (*p == '+' || *p == '-') {
+        sign = (*p == '-') ? -1 : 1;
+        p++;
+    }
+    if (!isdigit((unsigned char)*p)) {
+        return false;
+    }
+    int parts[3] = {0, 0, 0};
+    for (int i = 0; i < 3; i++) {
+        parts[i] = (int)strtol(p, (char**)&p, 10);
+        if (*p != ':' || i == 2) {
+            break;
+        }
+        p++;
+    }
+    seconds = sign * (parts[0] * 3600 + parts[1] * 60 + parts[2]);
+    return true;
+}
+
+static bool parse_name(const char*& p) {
+    if (*p == '<') {
+        while (*p && *p != '>') {
+            p++;
+        }
+        if (*p != '>') {
+            return false;
+        }
+        p++;
+        return true;
+    }
+    const char* start = p;
+    while (isalpha((unsigned char)*p)) {
+        p++;
+    }
+    return p - start >= 3;
+}
+
+static bool parse_date(const char*& p, char& kind, int& month, int& week, int& day, int& time) {
+    if (*p == 'M') {
+        kind = 'M';
+        p++;
+        month = (int)strtol(p, (char**)&p, 10);
+        if (*p++ != '.') {
+            return false;
+        }
+        week = (int)strtol(p, (char**)&p, 10);
+        if (*p++ != '.') {
+            return false;
+        }
+        day = (int)strtol(p, (char**)&p, 10);
+    } else if (*p == 'J') {
+        kind = 'J';
+        p++;
+        day = (int)strtol(p, (char**)&p, 10);
+    } else if (isdigit((unsigned char)*p)) {
+        kind = 'n';
+        day = (int)strtol(p, (char**)&p, 10);
+    } else {
+        return false;
+    }
+    time = 2 * 60 * 60;
+    if (*p == '/') {
+        p++;
+        return parse_time(p, time);
+    }
+    return true;
+}
+
+static bool parse_rule(const std::string& text, TimeZoneRule& rule) {
+    const char* p = text.c_str();
+    int offset = 0;
+    if (!parse_name(p) || !parse_time(p, offset)) {
+        return false;
+    }
+    // POSIX offsets are west of UTC
+    rule.stdOffset = -offset;
+    rule.hasDst = false;
+    if (*p == '\0') {
+        return true;
+    }
+    if (!parse_name(p)) {
+        return false;
+    }
+    rule.hasDst = true;
+    rule.dstOffset = rule.stdOffset + 60 * 60;
+    if (*p != ',' && *p != '\0') {
+        if (!parse_time(p, offset)) {
+            return false;
+        }
+        rule.dstOffset = -offset;
+    }
+    if (*p++ != ',') {
+        // No transition rule given, not worth guessing
+        return false;
+    }
+    if (!parse_date(p, rule.startKind, rule.startMonth, rule.startWeek, rule.startDay, rule.startTime)) {
+        return false;
+    }
+    if (*p++ != ',') {
+        return false;
+    }
+    return parse_date(p, rule.endKind, rule.endMonth, rule.endWeek, rule.endDay, rule.endTime);
+}
+
+// Days since 1970-01-01 that a POSIX rule date falls on in the given year
+static int64_t rule_day(int64_t year, char kind, int month, int week, int day) {
+    int64_t jan1 = days_from_civil(year, 1, 1);
+    if (kind == 'J') {
+        // 1-365, February 29th is never counted
+        int64_t d = jan1 + day - 1;
+        if (is_leap_year(year) && day >= 60) {
+            d += 1;
+        }
+        return d;
+    }
+    if (kind == 'n') {
+        return jan1 + day;
+    }
+    // Day of week "day" (0 = Sunday) in week "week" (5 = last) of "month"
+    int64_t first = days_from_civil(year, month, 1);
+    int firstWeekday = (int)(((first % 7) + 11) % 7); // 1970-01-01 was a Thursday
+    int dayOfMonth = 1 + ((day - firstWeekday + 7) % 7) + (week - 1) * 7;
+    while (dayOfMonth > days_in_month(year, month)) {
+        dayOfMonth -= 7;
+    }
+    return first + dayOfMonth - 1;
+}
+
+TimeZone::TimeZone() {
+    this->zoneName = "UTC";
+    this->initialOffset = 0;
+    this->hasRule = false;
+    this->rule = TimeZoneRule{};
+}
+
+bool TimeZone::load(const std::string& name) {
+    std::ifstream file(zoneInfoPath + name, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to open time zone " << name << std::endl;
+        return false;
+    }
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // See RFC 8536 for the TZif layout
+    const size_t headerSize = 44;
+    if (data.size() < headerSize || data[0] != 'T' || data[1] != 'Z' || data[2] != 'i' || data[3] != 'f') {
+        std::cout << "Invalid time zone file for " << name << std::endl;
+        return false;
+    }
+
+    size_t pos = 0;
+    int timeSize = 4;
+    if (data[4] >= '2') {
+        // Skip the 32-bit block, the 64-bit block and footer follow it
+        int64_t isutcnt = read_be(data, 20, 4);
+        int64_t isstdcnt = read_be(data, 24, 4);
+        int64_t leapcnt = read_be(data, 28, 4);
+        int64_t timecnt = read_be(data, 32, 4);
+        int64_t typecnt = read_be(data, 36, 4);
+        int64_t charcnt = read_be(data, 40, 4);
+        pos = headerSize + timecnt * 5 + typecnt * 6 + charcnt + leapcnt * 8 + isstdcnt + isutcnt;
+        timeSize = 8;
+    }
+    if (data.size() < pos + headerSize) {
+        std::cout << "Truncated time zone file for " << name << std::endl;
+        return false;
+    }
+
+    int64_t isutcnt = read_be(data, pos + 20, 4);
+    int64_t isstdcnt = read_be(data, pos + 24, 4);
+    int64_t leapcnt = read_be(data, pos + 28, 4);
+    int64_t timecnt = read_be(data, pos + 32, 4);
+    int64_t typecnt = read_be(data, pos + 36, 4);
+    int64_t charcnt = read_be(data, pos + 40, 4);
+    pos += headerSize;
+
+    size_t blockSize = timecnt * (timeSize + 1) + typecnt * 6 + charcnt
+        + leapcnt * (timeSize + 4) + isstdcnt + isutcnt;
+    if (typecnt < 1 || data.size() < pos + blockSize) {
+        std::cout << "Truncated time zone file for " << name << std::endl;
+        return false;
+    }
+
+    size_t typesPos = pos + timecnt * (timeSize + 1);
+    transitions.clear();
+    transitionOffsets.clear();
+    transitionIsDst.clear();
+    for (int64_t i = 0; i < timecnt; i++) {
+        int type = data[pos + timecnt * timeSize + i];
+        if (type >= typecnt) {
+            std::cout << "Invalid time zone file for " << name << std::endl;
+            transitions.clear();
+            transitionOffsets.clear();
+            transitionIsDst.clear();
+            return false;
+        }
+        transitions.push_back(read_be(data, pos + i * timeSize, timeSize));
+        transitionOffsets.push_back((int32_t)read_be(data, typesPos + type * 6, 4));
+        transitionIsDst.push_back(data[typesPos + type * 6 + 4] != 0);
+    }
+    initialOffset = (int32_t)read_be(data, typesPos, 4);
+
+    // Footer: "\n<POSIX TZ string>\n"
+    hasRule = false;
+    size_t footerPos = pos + blockSize;
+    if (timeSize == 8 && footerPos < data.size() && data[footerPos] == '\n') {
+        auto footerEnd = std::find(data.begin() + footerPos + 1, data.end(), '\n');
+        std::string footer(data.begin() + footerPos + 1, footerEnd);
+        if (!footer.empty()) {
+            hasRule = parse_rule(footer, rule);
+            if (!hasRule) {
+                std::cout << "Unsupported time zone rule for " << name << ": " << footer << std::endl;
+            }
+        }
+    }
+
+    zoneName = name;
+    std::cout << fmt::format("Loaded time zone {} ({} transitions)", name, transitions.size()) << std::endl;
+    return true;
+}
+
+const std::string& TimeZone::name() const {
+    return zoneName;
+}
+
+bool TimeZone::isDst(time_t timestamp) const {
+    if (!rule.hasDst) {
+        return false;
+    }
+    struct tm date;
+    time_t standard = timestamp + rule.stdOffset;
+    gmtime_r(&standard, &date);
+    int64_t year = date.tm_year + 1900;
+
+    // Start is given in standard time, end in daylight time
+    int64_t start = rule_day(year, rule.startKind, rule.startMonth, rule.startWeek, rule.startDay) * 86400
+        + rule.startTime - rule.stdOffset;
+    int64_t end = rule_day(year, rule.endKind, rule.endMonth, rule.endWeek, rule.endDay) * 86400
+        + rule.endTime - rule.dstOffset;
+    if (start < end) {
+        return timestamp >= start && timestamp < end;
+    }
+    // Southern hemisphere, daylight time wraps over the new year
+    return !(timestamp >= end && timestamp < start);
+}
+
+int TimeZone::utcOffset(time_t timestamp) const {
+    if (!transitions.empty() && timestamp < transitions.front()) {
+        return initialOffset;
+    }
+    if (hasRule && (transitions.empty() || timestamp >= transitions.back())) {
+        return isDst(timestamp) ? rule.dstOffset : rule.stdOffset;
+    }
+    if (transitions.empty()) {
+        return initialOffset;
+    }
+    auto it = std::upper_bound(transitions.begin(), transitions.end(), (int64_t)timestamp);
+    return transitionOffsets[(it - transitions.begin()) - 1];
+}
+
+struct tm TimeZone::toLocal(time_t timestamp) const {
+    struct tm local;
+    time_t shifted = timestamp + utcOffset(timestamp);
+    gmtime_r(&shifted, &local);
+
+    local.tm_isdst = 0;
+    if (hasRule && (transitions.empty() || timestamp >= transitions.back())) {
+        local.tm_isdst = isDst(timestamp);
+    } else if (!transitions.empty() && timestamp >= transitions.front()) {
+        auto it = std::upper_bound(transitions.begin(), transitions.end(), (int64_t)timestamp);
+        local.tm_isdst = transitionIsDst[(it - transitions.begin()) - 1];
+    }
+    return local;
+}
+
+time_t TimeZone::localMidnight(time_t timestamp) const {
+    int64_t local = timestamp + utcOffset(timestamp);
+    int64_t localDayStart = local - (((local % 86400) + 86400) % 86400);
+    // Offset at midnight may differ from now if a DST change happened since
+    time_t midnight = localDayStart - utcOffset(timestamp);
+    return localDayStart - utcOffset(midnight);
+}
+
+int TimeZone::secondsSinceLocalMidnight(time_t timestamp) const {
+    return (int)(timestamp - localMidnight(timestamp));
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <ctime>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// POSIX TZ rule, e.g. "EST5EDT,M3.2.0,M11.1.0", used past the last transition in the zone file
+typedef struct TimeZoneRule
+{
+    int stdOffset;  // Seconds east of UTC
+    int dstOffset;
+    bool hasDst;
+    char startKind; // 'M' (month.week.day), 'J' (julian, no leap day) or 'n' (zero-based day)
+    int startMonth, startWeek, startDay;
+    int startTime;  // Seconds after local midnight
+    char endKind;
+    int endMonth, endWeek, endDay;
+    int endTime;
+} TimeZoneRule;
+
+// Time zone loaded once from the system zoneinfo database (TZif files).
+// Conversions are plain lookups, so any number of zones can be used at once
+// from any thread, unlike localtime() which depends on the process-wide TZ.
+class TimeZone {
+    public:
+        // UTC until load() succeeds
+        TimeZone();
+
+        bool load(const std::string& name);
+        const std::string& name() const;
+
+        // Seconds east of UTC at the given instant
+        int utcOffset(time_t timestamp) const;
+        struct tm toLocal(time_t timestamp) const;
+
+        // UTC timestamp of the most recent local midnight
+        time_t localMidnight(time_t timestamp) const;
+        int secondsSinceLocalMidnight(time_t timestamp) const;
+
+    private:
+        std::string zoneName;
+        std::vector<int64_t> transitions;
+        std::vector<int32_t> transitionOffsets;
+        std::vector<bool> transitionIsDst;
+        int32_t initialOffset;
+        bool hasRule;
+        TimeZoneRule rule;
+
+        bool isDst(time_t timestamp) const;
+};
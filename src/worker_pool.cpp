@@ -0,0 +1,75 @@
+#include "worker_pool.h"
+
+WorkerPool::WorkerPool(int workerCount) {
+    this->currentJob = nullptr;
+    this->jobCount = 0;
+    this->nextIndex = 0;
+    this->remaining = 0;
+    this->generation = 0;
+    this->stopping = false;
+
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::parallelFor(int count, const std::function<void(int)>& job) {
+    if (count <= 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    currentJob = &job;
+    jobCount = count;
+    nextIndex = 0;
+    remaining = count;
+    generation++;
+    workReady.notify_all();
+
+    runJobs(lock);
+    workDone.wait(lock, [this] { return remaining == 0; });
+    currentJob = nullptr;
+}
+
+int WorkerPool::size() {
+    return workers.size();
+}
+
+void WorkerPool::workerLoop() {
+    unsigned long seenGeneration = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        workReady.wait(lock, [&] { return stopping || generation != seenGeneration; });
+        if (stopping) {
+            return;
+        }
+        seenGeneration = generation;
+        runJobs(lock);
+    }
+}
+
+// Takes job indices until none are left. Called with the lock held, released while a job runs.
+void WorkerPool::runJobs(std::unique_lock<std::mutex>& lock) {
+    while (currentJob != nullptr && nextIndex < jobCount) {
+        int index = nextIndex++;
+        const std::function<void(int)>* job = currentJob;
+        lock.unlock();
+        (*job)(index);
+        lock.lock();
+        remaining--;
+        if (remaining == 0) {
+            workDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+// Fixed set of worker threads for fanning out per-frame work.
+// The calling thread also takes jobs, so a pool of 0 workers runs everything inline.
+class WorkerPool {
+    public:
+        WorkerPool(int workerCount);
+        ~WorkerPool();
+
+        // Runs job(i) for every i in [0, count) and returns once all have finished
+        void parallelFor(int count, const std::function<void(int)>& job);
+
+        int size();
+
+    private:
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable workReady;
+        std::condition_variable workDone;
+
+        const std::function<void(int)>* currentJob;
+        int jobCount;
+        int nextIndex;
+        int remaining;
+        unsigned long generation;
+        bool stopping;
+
+        void workerLoop();
+        void runJobs(std::unique_lock<std::mutex>& lock);
+};